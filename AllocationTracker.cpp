@@ -0,0 +1,178 @@
+#include "AllocationTracker.h"
+#include <cstdlib>
+#include <new>
+
+// Plain thread locals so they are constant initialized and safe to touch from
+// inside operator new before anything else on the thread has run.
+static thread_local unsigned long long threadAllocationCount = 0;
+static thread_local unsigned long long threadAllocationBytes = 0;
+
+AllocationCounters AllocationTracker::Current()
+{
+	AllocationCounters counters;
+	counters.count = threadAllocationCount;
+	counters.bytes = threadAllocationBytes;
+	return counters;
+}
+
+static void* AlignedMalloc(std::size_t size, std::size_t alignment)
+{
+	if (alignment < sizeof(void*)) alignment = sizeof(void*);
+#ifdef _WIN32
+	return _aligned_malloc(size, alignment);
+#else
+	void* memory = nullptr;
+	return posix_memalign(&memory, alignment, size) == 0 ? memory : nullptr;
+#endif
+}
+
+/// <summary>
+/// Count the request, then allocate the way the standard operator new does:
+/// call the new handler and retry until it succeeds, throwing bad_alloc once
+/// no handler is installed.
+/// </summary>
+/// <param name="alignment"> 0 for default alignment. </param>
+static void* TrackedAllocate(std::size_t size, std::size_t alignment)
+{
+	threadAllocationCount++;
+	threadAllocationBytes += size;
+
+	if (size == 0) size = 1;
+	while (true)
+	{
+		void* memory = alignment == 0 ?
+			std::malloc(size) : AlignedMalloc(size, alignment);
+		if (memory != nullptr) return memory;
+
+		std::new_handler handler = std::get_new_handler();
+		if (handler == nullptr) throw std::bad_alloc();
+		handler();
+	}
+}
+
+static void* TrackedAllocateNoThrow(std::size_t size, std::size_t alignment) noexcept
+{
+	try
+	{
+		return TrackedAllocate(size, alignment);
+	}
+	catch (...)
+	{
+		return nullptr;
+	}
+}
+
+void* operator new(std::size_t size)
+{
+	return TrackedAllocate(size, 0);
+}
+
+void* operator new[](std::size_t size)
+{
+	return TrackedAllocate(size, 0);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return TrackedAllocateNoThrow(size, 0);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return TrackedAllocateNoThrow(size, 0);
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+	std::free(memory);
+}
+
+#ifdef __cpp_aligned_new
+
+// Over-aligned types use these from C++17 on, so they must be counted too
+
+static void AlignedFree(void* memory)
+{
+#ifdef _WIN32
+	_aligned_free(memory);
+#else
+	std::free(memory);
+#endif
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	return TrackedAllocate(size, (std::size_t)alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+	return TrackedAllocate(size, (std::size_t)alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return TrackedAllocateNoThrow(size, (std::size_t)alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return TrackedAllocateNoThrow(size, (std::size_t)alignment);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+	AlignedFree(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept
+{
+	AlignedFree(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept
+{
+	AlignedFree(memory);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept
+{
+	AlignedFree(memory);
+}
+
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	AlignedFree(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	AlignedFree(memory);
+}
+
+#endif
@@ -0,0 +1,61 @@
+#pragma once
+
+/// <summary>
+/// Number of heap allocations and bytes requested through operator new.
+/// </summary>
+struct AllocationCounters
+{
+	unsigned long long count = 0;
+	unsigned long long bytes = 0;
+
+	AllocationCounters& operator+=(const AllocationCounters& other)
+	{
+		count += other.count;
+		bytes += other.bytes;
+		return *this;
+	}
+
+	AllocationCounters operator-(const AllocationCounters& other) const
+	{
+		AllocationCounters result;
+		result.count = count - other.count;
+		result.bytes = bytes - other.bytes;
+		return result;
+	}
+};
+
+/// <summary>
+/// Reads the allocation totals gathered by the global operator new
+/// replacement in AllocationTracker.cpp. Totals are kept per thread so
+/// simulations running side by side do not see each other's allocations.
+/// </summary>
+class AllocationTracker
+{
+public:
+	/// <summary>
+	/// Totals for the calling thread since it started.
+	/// </summary>
+	static AllocationCounters Current();
+};
+
+/// <summary>
+/// Adds the allocations made on this thread during its lifetime to a
+/// counter, e.g. to attribute allocations to one phase of a frame.
+/// </summary>
+class AllocationScope
+{
+	AllocationCounters& target;
+	AllocationCounters start;
+
+public:
+	AllocationScope(AllocationCounters& target)
+		: target(target), start(AllocationTracker::Current()) {}
+
+	~AllocationScope()
+	{
+		target += AllocationTracker::Current() - start;
+	}
+
+	AllocationScope(const AllocationScope&) = delete;
+	AllocationScope& operator=(const AllocationScope&) = delete;
+};
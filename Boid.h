@@ -6,6 +6,21 @@
 #include "Bounds.h"
 #include "GridBins.h"
 
+/// <summary>
+/// Tuning parameters for the boid rules, one set per simulation.
+/// </summary>
+struct BoidSettings
+{
+	float maxSpeed = 4.0f;
+	float alignmentWeight = 3.0f;
+	float cohesionWeight = 1.0f;
+	float separationWeight = 2.0f;
+	float avoidEdgesWeight = 0.0f;
+	float separationDistance = 12.0f;
+	float senseDistance = 32.0f;
+	float forceFieldWeight = 1.0f;
+};
+
 struct Boid
 {	
 public:
@@ -14,16 +29,20 @@ public:
 	Vector3 velocity;
 	int binIndex;
 
-	static float maxSpeed;
-	static float alignmentWeight;
-	static float cohesionWeight;
-	static float avoidEdgesWeight;
-	static float separationWeight;
-	static float separationDistance;
-	static float senseDistance;
-
-	void Movement(std::vector<Boid> neighbors, Bounds bounds)
+	/// <summary>
+	/// Apply the boid rules for one step of the simulation.
+	/// </summary>
+	/// <param name="neighbors"> Boids within sense distance of this boid. </param>
+	/// <param name="neighborCount"> Number of entries in neighbors. </param>
+	/// <param name="bounds"> Bounds of the simulation. </param>
+	/// <param name="settings"> Rule weights and distances to apply. </param>
+	/// <param name="fieldForce"> Force sampled from the flock's force field. </param>
+	/// <param name="deltaTime"> Length of the step in seconds. </param>
+	void Movement(Boid* const* neighbors, int neighborCount, Bounds bounds, 
+		const BoidSettings& settings, Vector3 fieldForce, float deltaTime)
 	{
+        float maxSpeed = settings.maxSpeed;
+
         // Set base values for boid rules
         Vector3 alignment =  { 0.0f, 0.0f, 0.0f };
         Vector3 cohesion =   { 0.0f, 0.0f, 0.0f };
@@ -32,9 +51,9 @@ public:
 
 		// Loop through neighbors and sum effect of rules
         int count = 0;
-        for (size_t i = 0; i < neighbors.size(); i++)
+        for (int i = 0; i < neighborCount; i++)
         {
-			Boid b = neighbors[i];
+			const Boid& b = *neighbors[i];
 			if (b.id == id) continue;
 
 			Vector3 bPos = b.position;
@@ -42,7 +61,7 @@ public:
 
 			alignment += b.velocity;
             cohesion  += bPos;
-			if (Vector3Length(toBoid) < separationDistance)
+			if (Vector3Length(toBoid) < settings.separationDistance)
 				separation -= Vector3Normalize(toBoid);
 
 			count++;
@@ -70,12 +89,12 @@ public:
         }
 
         // Caclulate new velocity
-        float deltaTime = GetFrameTime();
         velocity += (
-            alignment  * alignmentWeight +
-            cohesion   * cohesionWeight +
-            separation * separationWeight +
-            seekCenter * avoidEdgesWeight) * deltaTime;
+            alignment  * settings.alignmentWeight +
+            cohesion   * settings.cohesionWeight +
+            separation * settings.separationWeight +
+            seekCenter * settings.avoidEdgesWeight +
+            fieldForce * settings.forceFieldWeight) * deltaTime;
         velocity = Vector3Normalize(velocity) * maxSpeed;
 
 		// Apply velocity to position
@@ -0,0 +1,91 @@
+// Example external consumer of the shared swarm region.
+//
+// Build alongside the reader library, without raylib:
+//     g++ -std=c++14 -I.. SwarmConsumer.cpp ../SwarmSharedMemory.cpp -o SwarmConsumer -lrt
+// Run the simulation with --publish, then start this with the same name.
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include "SwarmReader.h"
+
+int main(int argc, char* argv[])
+{
+    const char* name = argc > 1 ? argv[1] : SwarmSharedMemoryDefaultName;
+
+    SwarmReader reader;
+    while (true)
+    {
+        while (!reader.Open(name))
+        {
+            std::cout << "Waiting for swarm region " << name << "..." << std::endl;
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+        }
+
+        std::cout << "Attached to " << name << " (capacity "
+            << reader.Capacity() << ")" << std::endl;
+
+        // Detach once the writer closes, or when no new frame has arrived for
+        // a while since a crashed writer cannot say it has gone
+        const int maxStalePolls = 10;
+        int stalePolls = 0;
+        uint64_t lastFrame = 0;
+        while (reader.IsWriterOpen() && stalePolls < maxStalePolls)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+            // Read straight out of the mapping, retry if the frame was 
+            // replaced while it was being summarized
+            uint32_t sequence;
+            if (!reader.TryBeginRead(sequence))
+            {
+                stalePolls++;
+                continue;
+            }
+
+            uint64_t frameNumber = reader.FrameNumber();
+            uint32_t count = reader.BoidCount();
+            const float* positions = reader.Positions();
+            const float* velocities = reader.Velocities();
+
+            double cx = 0.0, cy = 0.0, cz = 0.0, speed = 0.0;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                cx += positions[i * 3 + 0];
+                cy += positions[i * 3 + 1];
+                cz += positions[i * 3 + 2];
+                speed += std::sqrt(
+                    velocities[i * 3 + 0] * velocities[i * 3 + 0] +
+                    velocities[i * 3 + 1] * velocities[i * 3 + 1] +
+                    velocities[i * 3 + 2] * velocities[i * 3 + 2]);
+            }
+
+            if (!reader.EndRead(sequence)) continue;
+
+            if (frameNumber == lastFrame)
+            {
+                stalePolls++;
+                continue;
+            }
+
+            stalePolls = 0;
+            lastFrame = frameNumber;
+            if (count > 0)
+            {
+                std::cout << "Frame " << frameNumber
+                    << " | boids: " << count
+                    << " | centroid: " << cx / count << ", " << cy / count << ", " << cz / count
+                    << " | mean speed: " << speed / count << std::endl;
+            }
+        }
+
+        if (reader.IsWriterOpen())
+            std::cout << "No new frames from " << name << ", detaching" << std::endl;
+        else
+            std::cout << "Simulation closed " << name << ", detaching" << std::endl;
+        reader.Close();
+    }
+
+    return 0;
+}
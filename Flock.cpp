@@ -0,0 +1 @@
+#include "Flock.h"
@@ -0,0 +1,226 @@
+#pragma once
+#include <random>
+#include <vector>
+#include "raylib.h"
+#include "raymath.h"
+#include "AllocationTracker.h"
+#include "Boid.h"
+#include "Bounds.h"
+#include "ForceField.h"
+#include "FrameArena.h"
+
+/// <summary>
+/// Allocations made during one step of the flock, split by phase.
+/// </summary>
+struct FlockFrameStats
+{
+	AllocationCounters step;
+	AllocationCounters neighbors;
+	AllocationCounters movement;
+	size_t arenaBytes = 0;
+	float meanNeighborCount = 0.0f;
+};
+
+/// <summary>
+/// Owns the boids of one simulation and advances them a step at a time,
+/// independent of any window so it can also run headless. Each flock has its
+/// own settings and random generator, so many can run side by side.
+/// </summary>
+class Flock
+{
+	std::vector<Boid> boids;
+	Bounds bounds;
+	BoidSettings settings;
+	std::mt19937 random;
+	FrameArena arena;
+	FlockFrameStats lastFrameStats;
+	ForceField* forceField = nullptr;
+
+public:
+	Flock(Bounds bounds, BoidSettings settings = BoidSettings(), 
+		unsigned int seed = std::mt19937::default_seed)
+		: bounds(bounds), settings(settings), random(seed) {}
+
+	BoidSettings& Settings()
+	{
+		return settings;
+	}
+
+	/// <summary>
+	/// Field sampled by every boid each step, or nullptr for none. The flock
+	/// does not own the field.
+	/// </summary>
+	void SetForceField(ForceField* field)
+	{
+		forceField = field;
+	}
+
+	std::vector<Boid>& Boids()
+	{
+		return boids;
+	}
+
+	int Count() const
+	{
+		return (int)boids.size();
+	}
+
+	const FlockFrameStats& LastFrameStats() const
+	{
+		return lastFrameStats;
+	}
+
+	/// <summary>
+	/// Replace the flock with count boids at random positions inside the
+	/// bounds, moving in random directions at max speed.
+	/// </summary>
+	void Spawn(int count)
+	{
+		boids.clear();
+		boids.reserve(count);
+
+		Vector3 min = bounds.Min();
+		Vector3 max = bounds.Max();
+		std::uniform_real_distribution<float> randomX(min.x, max.x);
+		std::uniform_real_distribution<float> randomY(min.y, max.y);
+		std::uniform_real_distribution<float> randomZ(min.z, max.z);
+		std::uniform_real_distribution<float> randomDirection(-1.0f, 1.0f);
+		for (int i = 0; i < count; i++)
+		{
+			// Generate a random position and velocity for each boid.
+			// Position is within the bounds, velocity is normalized and scaled
+			// to max speed.
+			Vector3 pos = { randomX(random), randomY(random), randomZ(random) };
+
+			Vector3 vel =
+			{
+				randomDirection(random),
+				randomDirection(random),
+				randomDirection(random)
+			};
+
+			vel = Vector3Normalize(vel);
+			vel = Vector3Scale(vel, settings.maxSpeed);
+
+			boids.push_back(Boid{ i, pos, vel });
+		}
+	}
+
+	/// <summary>
+	/// Advance every boid by one step.
+	/// </summary>
+	/// <param name="deltaTime"> Length of the step in seconds. </param>
+	void Step(float deltaTime)
+	{
+		FlockFrameStats stats;
+		{
+			AllocationScope stepScope(stats.step);
+
+			// Grow the arena only when the flock has grown, so the neighbor
+			// list always fits and steady-state steps never allocate
+			int count = Count();
+			arena.Reserve(sizeof(Boid*) * count + alignof(Boid*));
+			arena.Reset();
+
+			// Pick up any force sources that changed since the last step
+			if (forceField != nullptr) forceField->Bake();
+
+			// One scratch neighbor list, reused by every boid this step
+			Boid** neighbors = arena.Allocate<Boid*>(count);
+			long long neighborTotal = 0;
+
+			for (int i = 0; i < count; i++)
+			{
+				Boid& boid = boids[i];
+
+				int neighborCount = 0;
+				{
+					AllocationScope neighborScope(stats.neighbors);
+					for (int j = 0; j < count; j++)
+					{
+						if (boids[j].id == boid.id) continue;
+
+						if (Vector3Distance(boids[j].position, boid.position) <=
+							settings.senseDistance)
+							neighbors[neighborCount++] = &boids[j];
+					}
+				}
+				neighborTotal += neighborCount;
+
+				// Update the boid's data
+				{
+					AllocationScope movementScope(stats.movement);
+					Vector3 fieldForce = forceField != nullptr ?
+						forceField->Sample(boid.position) : Vector3{ 0.0f, 0.0f, 0.0f };
+					boid.Movement(neighbors, neighborCount, bounds, settings, 
+						fieldForce, deltaTime);
+					boid.FixToBounds(bounds);
+				}
+			}
+
+			stats.arenaBytes = arena.Used();
+			if (count > 0) stats.meanNeighborCount = (float)neighborTotal / count;
+		}
+
+		lastFrameStats = stats;
+	}
+
+	/// <summary>
+	/// How aligned the flock is: the length of the mean heading.
+	/// </summary>
+	/// <returns> 1 if every boid moves the same way, near 0 if disordered. </returns>
+	float Polarization()
+	{
+		if (boids.empty()) return 0.0f;
+
+		Vector3 sum = { 0.0f, 0.0f, 0.0f };
+		for (size_t i = 0; i < boids.size(); i++)
+			sum += Vector3Normalize(boids[i].velocity);
+
+		return Vector3Length(sum) / boids.size();
+	}
+
+	/// <summary>
+	/// Count groups of boids connected through chains of boids within sense
+	/// distance of each other.
+	/// </summary>
+	int ClusterCount()
+	{
+		int count = Count();
+		std::vector<int> parent(count);
+		for (int i = 0; i < count; i++)
+			parent[i] = i;
+
+		// Union-find over every pair of boids that can sense each other
+		int clusters = count;
+		for (int i = 0; i < count; i++)
+		{
+			for (int j = i + 1; j < count; j++)
+			{
+				if (Vector3Distance(boids[i].position, boids[j].position) >
+					settings.senseDistance)
+					continue;
+
+				int a = FindRoot(parent, i);
+				int b = FindRoot(parent, j);
+				if (a == b) continue;
+
+				parent[b] = a;
+				clusters--;
+			}
+		}
+
+		return clusters;
+	}
+
+private:
+	static int FindRoot(std::vector<int>& parent, int i)
+	{
+		while (parent[i] != i)
+		{
+			parent[i] = parent[parent[i]];
+			i = parent[i];
+		}
+		return i;
+	}
+};
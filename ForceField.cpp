@@ -0,0 +1,64 @@
+#include "ForceField.h"
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+bool ForceField::Load(const std::string& path)
+{
+	std::ifstream file(path);
+	if (!file)
+	{
+		std::cout << "Could not open force field " << path << std::endl;
+		return false;
+	}
+
+	std::string key;
+	int fileResolution = 0;
+	if (!(file >> key >> fileResolution) || key != "resolution" || fileResolution < 2)
+	{
+		std::cout << path << ": expected \"resolution N\" with N >= 2" << std::endl;
+		return false;
+	}
+
+	std::vector<Vector3> loaded(fileResolution * fileResolution * fileResolution);
+	for (size_t i = 0; i < loaded.size(); i++)
+	{
+		if (!(file >> loaded[i].x >> loaded[i].y >> loaded[i].z))
+		{
+			std::cout << path << ": expected " << loaded.size() << " samples, found " << i << std::endl;
+			return false;
+		}
+	}
+
+	// Sources are rebaked on top of the loaded samples
+	Resize(fileResolution);
+	baseSamples.swap(loaded);
+	MarkAllDirty();
+	return true;
+}
+
+bool ForceField::Save(const std::string& path, bool flatten)
+{
+	if (flatten) Bake();
+
+	std::ofstream file(path);
+	if (!file)
+	{
+		std::cout << "Could not open " << path << " for writing" << std::endl;
+		return false;
+	}
+
+	// Enough digits that Load reads back exactly what was written
+	file.precision(std::numeric_limits<float>::max_digits10);
+
+	file << "resolution " << resolution << "\n";
+	Vector3 zero = { 0.0f, 0.0f, 0.0f };
+	for (size_t i = 0; i < samples.size(); i++)
+	{
+		const Vector3& sample = flatten ? samples[i] :
+			baseSamples.empty() ? zero : baseSamples[i];
+		file << sample.x << " " << sample.y << " " << sample.z << "\n";
+	}
+
+	return (bool)file;
+}
@@ -0,0 +1,399 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <math.h>
+#include "raylib.h"
+#include "raymath.h"
+#include "Bounds.h"
+
+enum ForceSourceType
+{
+	FORCE_WIND,        // Pushes along direction, everywhere or within radius
+	FORCE_ATTRACTOR,   // Pulls toward position, fading out at radius
+	FORCE_REPULSOR     // Pushes away from position, fading out at radius
+};
+
+/// <summary>
+/// An analytic force baked into a ForceField.
+/// </summary>
+struct ForceSource
+{
+	ForceSourceType type;
+	Vector3 position;
+	Vector3 direction;
+	float radius;      // Wind with radius <= 0 covers the whole field
+	float strength;
+};
+
+/// <summary>
+/// Inclusive range of sample coordinates in a ForceField.
+/// </summary>
+struct ForceFieldRegion
+{
+	int min[3];
+	int max[3];
+
+	int SampleCount() const
+	{
+		return (max[0] - min[0] + 1) * (max[1] - min[1] + 1) * (max[2] - min[2] + 1);
+	}
+
+	bool Overlaps(const ForceFieldRegion& other) const
+	{
+		for (int i = 0; i < 3; i++)
+			if (min[i] > other.max[i] || other.min[i] > max[i]) return false;
+		return true;
+	}
+
+	ForceFieldRegion Union(const ForceFieldRegion& other) const
+	{
+		ForceFieldRegion result;
+		for (int i = 0; i < 3; i++)
+		{
+			result.min[i] = min[i] < other.min[i] ? min[i] : other.min[i];
+			result.max[i] = max[i] > other.max[i] ? max[i] : other.max[i];
+		}
+		return result;
+	}
+};
+
+/// <summary>
+/// Forces baked into a 3D grid of samples spanning the bounds. Boids sample the
+/// grid with trilinear interpolation, so per-boid cost does not depend on how
+/// many sources there are. Changing a source only rebakes the samples it can
+/// reach. Up to MaxDirtyRegions separate regions are kept between bakes, so
+/// sources far apart do not rebake the space between them.
+/// </summary>
+class ForceField
+{
+	Bounds bounds;
+	int resolution;
+	Vector3 cellSize;
+	std::vector<Vector3> samples;
+	std::vector<Vector3> baseSamples;   // Loaded from file, empty if none
+	std::vector<ForceSource> sources;
+
+	// Disjoint regions waiting to be rebaked
+	static const int MaxDirtyRegions = 8;
+	ForceFieldRegion dirtyRegions[MaxDirtyRegions];
+	int dirtyRegionCount = 0;
+
+public:
+	/// <param name="bounds"> Region the field covers. </param>
+	/// <param name="resolution"> Samples along each axis, at least 2. </param>
+	ForceField(Bounds bounds, int resolution)
+		: bounds(bounds), resolution(0), cellSize{ 0.0f, 0.0f, 0.0f }
+	{
+		Resize(resolution);
+	}
+
+	int Resolution() const
+	{
+		return resolution;
+	}
+
+	Vector3 CellSize() const
+	{
+		return cellSize;
+	}
+
+	const std::vector<ForceSource>& Sources() const
+	{
+		return sources;
+	}
+
+	bool IsDirty() const
+	{
+		return dirtyRegionCount > 0;
+	}
+
+	int DirtyRegionCount() const
+	{
+		return dirtyRegionCount;
+	}
+
+	/// <summary>
+	/// A region of samples the next Bake will recompute.
+	/// </summary>
+	const ForceFieldRegion& DirtyRegion(int index) const
+	{
+		return dirtyRegions[index];
+	}
+
+	int SampleIndex(int x, int y, int z) const
+	{
+		return x + y * resolution + z * resolution * resolution;
+	}
+
+	/// <summary>
+	/// World position of a grid sample.
+	/// </summary>
+	Vector3 SamplePosition(int x, int y, int z)
+	{
+		Vector3 min = bounds.Min();
+		return Vector3
+		{
+			min.x + x * cellSize.x,
+			min.y + y * cellSize.y,
+			min.z + z * cellSize.z
+		};
+	}
+
+	/// <summary>
+	/// Baked force at a grid sample.
+	/// </summary>
+	Vector3 SampleAt(int x, int y, int z) const
+	{
+		return samples[SampleIndex(x, y, z)];
+	}
+
+	/// <summary>
+	/// Add a source and mark the samples it reaches for rebaking.
+	/// </summary>
+	/// <returns> Index of the source, for later updates. </returns>
+	int AddSource(ForceSource source)
+	{
+		sources.push_back(source);
+		MarkDirty(source);
+		return (int)sources.size() - 1;
+	}
+
+	/// <summary>
+	/// Replace a source, rebaking what it reached before and after.
+	/// </summary>
+	void SetSource(int index, ForceSource source)
+	{
+		if (index < 0 || index >= (int)sources.size()) return;
+
+		MarkDirty(sources[index]);
+		sources[index] = source;
+		MarkDirty(source);
+	}
+
+	void MoveSource(int index, Vector3 position)
+	{
+		if (index < 0 || index >= (int)sources.size()) return;
+
+		ForceSource source = sources[index];
+		source.position = position;
+		SetSource(index, source);
+	}
+
+	/// <summary>
+	/// Mark every sample for rebaking.
+	/// </summary>
+	void MarkAllDirty()
+	{
+		dirtyRegionCount = 0;
+		MarkDirty(ForceFieldRegion{ { 0, 0, 0 },
+			{ resolution - 1, resolution - 1, resolution - 1 } });
+	}
+
+	/// <summary>
+	/// Recompute the samples marked dirty since the last bake.
+	/// </summary>
+	void Bake()
+	{
+		for (int i = 0; i < dirtyRegionCount; i++)
+			BakeRegion(dirtyRegions[i]);
+
+		dirtyRegionCount = 0;
+	}
+
+	/// <summary>
+	/// Trilinearly interpolate the baked force at a world position. Positions
+	/// outside the bounds use the nearest edge of the field.
+	/// </summary>
+	Vector3 Sample(Vector3 position)
+	{
+		Vector3 min = bounds.Min();
+		float fx = Clamp((position.x - min.x) / cellSize.x, 0.0f, (float)(resolution - 1));
+		float fy = Clamp((position.y - min.y) / cellSize.y, 0.0f, (float)(resolution - 1));
+		float fz = Clamp((position.z - min.z) / cellSize.z, 0.0f, (float)(resolution - 1));
+
+		// Lower corner of the cell, kept one short of the far edge so the
+		// upper corner always exists
+		int x = fx >= resolution - 1 ? resolution - 2 : (int)fx;
+		int y = fy >= resolution - 1 ? resolution - 2 : (int)fy;
+		int z = fz >= resolution - 1 ? resolution - 2 : (int)fz;
+		float tx = fx - x, ty = fy - y, tz = fz - z;
+
+		const Vector3* s = samples.data();
+		int i = SampleIndex(x, y, z);
+		int dy = resolution;
+		int dz = resolution * resolution;
+
+		Vector3 c00 = Vector3Lerp(s[i], s[i + 1], tx);
+		Vector3 c10 = Vector3Lerp(s[i + dy], s[i + dy + 1], tx);
+		Vector3 c01 = Vector3Lerp(s[i + dz], s[i + dz + 1], tx);
+		Vector3 c11 = Vector3Lerp(s[i + dy + dz], s[i + dy + dz + 1], tx);
+
+		return Vector3Lerp(Vector3Lerp(c00, c10, ty), Vector3Lerp(c01, c11, ty), tz);
+	}
+
+	/// <summary>
+	/// Load a baked field to use as the base that sources are added to. The
+	/// file holds "resolution N" followed by N^3 "x y z" samples, x fastest.
+	/// </summary>
+	/// <returns> False if the file could not be read. </returns>
+	bool Load(const std::string& path);
+
+	/// <summary>
+	/// Save the field in the format read by Load. By default only the base
+	/// grid is written (zeros if none was loaded), so loading it into a field
+	/// with the same sources reproduces this one. Flattening writes the baked
+	/// samples, sources included, and is meant to be loaded into a field with
+	/// no sources, otherwise they are counted twice.
+	/// </summary>
+	/// <returns> False if the file could not be written. </returns>
+	bool Save(const std::string& path, bool flatten = false);
+
+	/// <summary>
+	/// Force a single source applies at a point.
+	/// </summary>
+	static Vector3 Evaluate(const ForceSource& source, Vector3 point)
+	{
+		Vector3 zero = { 0.0f, 0.0f, 0.0f };
+
+		if (source.type == FORCE_WIND)
+		{
+			if (source.radius <= 0.0f)
+				return Vector3Normalize(source.direction) * source.strength;
+
+			float distance = Vector3Distance(point, source.position);
+			if (distance >= source.radius) return zero;
+			return Vector3Normalize(source.direction) *
+				(source.strength * (1.0f - distance / source.radius));
+		}
+
+		Vector3 toSource = source.position - point;
+		float distance = Vector3Length(toSource);
+		if (distance >= source.radius || distance <= 0.0f) return zero;
+
+		// Linear falloff to nothing at the radius
+		float falloff = 1.0f - distance / source.radius;
+		Vector3 force = (toSource / distance) * (source.strength * falloff);
+		return source.type == FORCE_REPULSOR ? -force : force;
+	}
+
+private:
+	void Resize(int newResolution)
+	{
+		resolution = newResolution < 2 ? 2 : newResolution;
+		Vector3 size = bounds.Size();
+		cellSize = Vector3
+		{
+			size.x / (resolution - 1),
+			size.y / (resolution - 1),
+			size.z / (resolution - 1)
+		};
+
+		samples.assign(resolution * resolution * resolution, Vector3{ 0.0f, 0.0f, 0.0f });
+		baseSamples.clear();
+		MarkAllDirty();
+	}
+
+	void BakeRegion(const ForceFieldRegion& region)
+	{
+		for (int z = region.min[2]; z <= region.max[2]; z++)
+		{
+			for (int y = region.min[1]; y <= region.max[1]; y++)
+			{
+				for (int x = region.min[0]; x <= region.max[0]; x++)
+				{
+					int index = SampleIndex(x, y, z);
+					Vector3 point = SamplePosition(x, y, z);
+
+					Vector3 force = baseSamples.empty() ?
+						Vector3{ 0.0f, 0.0f, 0.0f } : baseSamples[index];
+					for (size_t i = 0; i < sources.size(); i++)
+						force += Evaluate(sources[i], point);
+
+					samples[index] = force;
+				}
+			}
+		}
+	}
+
+	void MarkDirty(ForceFieldRegion region)
+	{
+		while (true)
+		{
+			// Absorb pending regions this one overlaps, so no sample is baked
+			// twice. Growing may reach regions already checked, so start over.
+			for (int i = 0; i < dirtyRegionCount; i++)
+			{
+				if (!region.Overlaps(dirtyRegions[i])) continue;
+
+				region = region.Union(dirtyRegions[i]);
+				dirtyRegions[i] = dirtyRegions[--dirtyRegionCount];
+				i = -1;
+			}
+
+			if (dirtyRegionCount < MaxDirtyRegions) break;
+
+			// Out of room, merge with whichever region grows the least
+			int best = 0;
+			int bestGrowth = 0;
+			for (int i = 0; i < dirtyRegionCount; i++)
+			{
+				int growth = region.Union(dirtyRegions[i]).SampleCount() -
+					dirtyRegions[i].SampleCount();
+				if (i == 0 || growth < bestGrowth)
+				{
+					best = i;
+					bestGrowth = growth;
+				}
+			}
+
+			region = region.Union(dirtyRegions[best]);
+			dirtyRegions[best] = dirtyRegions[--dirtyRegionCount];
+		}
+
+		dirtyRegions[dirtyRegionCount++] = region;
+	}
+
+	/// <summary>
+	/// Mark the samples a source can reach.
+	/// </summary>
+	void MarkDirty(const ForceSource& source)
+	{
+		if (source.type == FORCE_WIND && source.radius <= 0.0f)
+		{
+			MarkAllDirty();
+			return;
+		}
+
+		Vector3 min = bounds.Min();
+		ForceFieldRegion region =
+		{
+			{
+				(int)floorf((source.position.x - source.radius - min.x) / cellSize.x),
+				(int)floorf((source.position.y - source.radius - min.y) / cellSize.y),
+				(int)floorf((source.position.z - source.radius - min.z) / cellSize.z)
+			},
+			{
+				(int)ceilf((source.position.x + source.radius - min.x) / cellSize.x),
+				(int)ceilf((source.position.y + source.radius - min.y) / cellSize.y),
+				(int)ceilf((source.position.z + source.radius - min.z) / cellSize.z)
+			}
+		};
+
+		for (int i = 0; i < 3; i++)
+		{
+			if (region.min[i] < 0) region.min[i] = 0;
+			if (region.max[i] > resolution - 1) region.max[i] = resolution - 1;
+		}
+
+		// Entirely outside the field on some axis
+		if ((source.position.x + source.radius < min.x) ||
+			(source.position.y + source.radius < min.y) ||
+			(source.position.z + source.radius < min.z) ||
+			(source.position.x - source.radius > bounds.Max().x) ||
+			(source.position.y - source.radius > bounds.Max().y) ||
+			(source.position.z - source.radius > bounds.Max().z))
+			return;
+
+		MarkDirty(region);
+	}
+};
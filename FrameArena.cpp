@@ -0,0 +1 @@
+#include "FrameArena.h"
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+/// <summary>
+/// Bump allocator for data that only lives for one simulation step. Memory is
+/// handed out from one preallocated block and released all at once by
+/// Reset(), so steady-state frames never touch the heap.
+/// </summary>
+class FrameArena
+{
+	std::vector<unsigned char> buffer;
+	size_t offset = 0;
+	size_t overflow = 0;
+	size_t peak = 0;
+
+public:
+	FrameArena(size_t capacity = 0) : buffer(capacity) {}
+
+	size_t Capacity() const
+	{
+		return buffer.size();
+	}
+
+	size_t Used() const
+	{
+		return offset;
+	}
+
+	/// <summary> Largest amount requested in a single frame so far. </summary>
+	size_t Peak() const
+	{
+		return peak;
+	}
+
+	/// <summary>
+	/// Grow the block ahead of time. Invalidates anything already allocated.
+	/// </summary>
+	void Reserve(size_t capacity)
+	{
+		if (capacity <= buffer.size()) return;
+		buffer.resize(capacity);
+		offset = 0;
+		overflow = 0;
+	}
+
+	/// <summary>
+	/// Release everything allocated since the last reset. If the last frame
+	/// ran out of room, the block grows here so the next frame fits.
+	/// </summary>
+	void Reset()
+	{
+		size_t demand = offset + overflow;
+		if (demand > peak) peak = demand;
+		if (demand > buffer.size()) buffer.resize(demand);
+		offset = 0;
+		overflow = 0;
+	}
+
+	/// <summary>
+	/// Allocate uninitialized, suitably aligned storage for count items.
+	/// </summary>
+	/// <returns> nullptr if the arena is out of room for this frame. </returns>
+	template <typename T> T* Allocate(size_t count)
+	{
+		const size_t alignment = alignof(T);
+		size_t start = (offset + alignment - 1) & ~(alignment - 1);
+		size_t end = start + sizeof(T) * count;
+
+		// Remember what did not fit so Reset can grow to the full demand
+		if (end > buffer.size())
+		{
+			overflow += sizeof(T) * count + alignment;
+			return nullptr;
+		}
+
+		offset = end;
+		return reinterpret_cast<T*>(buffer.data() + start);
+	}
+};
@@ -33,7 +33,7 @@ public:
 		}
 	}
 
-	std::vector<std::vector<T>> Bins()
+	std::vector<std::vector<T>>& Bins()
 	{
 		return bins;
 	}
@@ -162,10 +162,11 @@ public:
 	/// Get the indices of bins directly surrounding the given bin index.
 	/// </summary>
 	/// <param name="index"> The index of the bin to query neighbors of. </param>
-	/// <returns> A vector containing </returns>
-	std::vector<int> GetNeighborBinIndices(int index, bool includeIndexedBin)
+	/// <param name="results"> Output buffer, must hold at least 27 indices. </param>
+	/// <returns> The number of indices written to results. </returns>
+	int GetNeighborBinIndices(int index, bool includeIndexedBin, int* results)
 	{
-		std::vector<int> results = std::vector<int>();
+		int count = 0;
 
 		// TODO: Check conversion works as intended
 		int ix = index % binDensity;
@@ -187,14 +188,14 @@ public:
 					if (x < binDensity - 2 && x > 0 &&
 						y < binDensity - 2 && y > 0 &&
 						z < binDensity - 2 && z > 0)
-						results.push_back(x + 
+						results[count++] = x + 
 							y * binDensity + 
-							z * binDensity * binDensity);
+							z * binDensity * binDensity;
 				}
 			}
 		}
 
-		return results;
+		return count;
 	}
 };
 
@@ -1,23 +1,155 @@
 #include <iostream>
 #include <array>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstring>
+#include <ctime>
 #include "raylib.h"
 #include "raymath.h"
 #include "Bounds.h"
 #include "GridBins.h"
 #include "Boid.h"
+#include "Flock.h"
+#include "ForceField.h"
+#include "AllocationTracker.h"
+#include "ParameterSweep.h"
+#include "SwarmPublisher.h"
 #include "Tests.h"
 
+// Set by Ctrl+C or a termination request, so the main loops can end and
+// close the shared region instead of leaving it behind
+static volatile std::sig_atomic_t stopRequested = 0;
+
+static void RequestStop(int)
+{
+    stopRequested = 1;
+}
+
 int main(int argc, char* argv[])
 {
+    // Parse command line options
+    // --publish [name]: share each frame with external readers, see SwarmReader.h
+    // --headless [frames]: run without a window, printing per-frame stats
+    // --sweep <spec> [csv]: run a parameter sweep, see ParameterSweep.h
+    // --field <path>: start the force field from a grid saved by ForceField::Save
+    // --tests: run the allocation and force field tests, exit non-zero on failure
+    const char* publishName = nullptr;
+    int headlessFrames = 0;
+    const char* fieldPath = nullptr;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--publish") == 0)
+        {
+            publishName = SwarmSharedMemoryDefaultName;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+                publishName = argv[++i];
+        }
+        else if (strcmp(argv[i], "--headless") == 0)
+        {
+            headlessFrames = 600;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+                headlessFrames = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--field") == 0)
+        {
+            if (i + 1 >= argc || argv[i + 1][0] == '-')
+            {
+                std::cout << "Usage: --field <path>" << std::endl;
+                return 1;
+            }
+
+            fieldPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--sweep") == 0)
+        {
+            if (i + 1 >= argc || argv[i + 1][0] == '-')
+            {
+                std::cout << "Usage: --sweep <spec> [csv]" << std::endl;
+                return 1;
+            }
+
+            const char* specPath = argv[i + 1];
+            const char* csvPath = "sweep.csv";
+            if (i + 2 < argc && argv[i + 2][0] != '-')
+                csvPath = argv[i + 2];
+            return ParameterSweep::Run(specPath, csvPath) ? 0 : 1;
+        }
+        else if (strcmp(argv[i], "--tests") == 0)
+        {
+            bool passed = Tests::TestSteadyStateAllocations(200, 5, 30);
+            passed = Tests::TestForceFieldDirtyBake(50, 16) && passed;
+            return passed ? 0 : 1;
+        }
+    }
+
+    Bounds bounds = { Vector3{ 0.0f, 0.0f, 0.0f }, Vector3One() * 200 };
+    const int spawnCount = 1000;
+
+    // Headless runs are seeded the same every time so they can be compared
+    unsigned int seed = headlessFrames > 0 ? 1 : (unsigned int)time(nullptr);
+    Flock flock = Flock(bounds, BoidSettings(), seed);
+
+    // Force field every boid samples, starting from a loaded grid if given.
+    // Headless runs only use the field when one is loaded.
+    ForceField forceField = ForceField(bounds, 24);
+    if (fieldPath != nullptr)
+    {
+        if (!forceField.Load(fieldPath)) return 1;
+        flock.SetForceField(&forceField);
+    }
+
+    std::signal(SIGINT, RequestStop);
+    std::signal(SIGTERM, RequestStop);
+
+    // Open the shared memory region for external readers if requested
+    SwarmPublisher publisher;
+    if (publishName != nullptr && !publisher.Open(publishName, spawnCount))
+    {
+        std::cout << "Failed to open shared swarm region " << publishName << std::endl;
+        return 1;
+    }
+    uint64_t frameNumber = 0;
+
+    // Run a fixed number of steps without a window
+    if (headlessFrames > 0)
+    {
+        const float deltaTime = 1.0f / 60.0f;
+        flock.Spawn(spawnCount);
+
+        for (int frame = 0; frame < headlessFrames && !stopRequested; frame++)
+        {
+            AllocationCounters publishAllocations;
+
+            auto start = std::chrono::steady_clock::now();
+            flock.Step(deltaTime);
+            {
+                AllocationScope publishScope(publishAllocations);
+                publisher.Publish(++frameNumber, flock.Boids().data(), flock.Count());
+            }
+            auto end = std::chrono::steady_clock::now();
+
+            const FlockFrameStats& stats = flock.LastFrameStats();
+            std::cout << "Frame " << frameNumber
+                << " | " << std::chrono::duration<double, std::milli>(end - start).count() << " ms"
+                << " | allocs: " << stats.step.count + publishAllocations.count
+                << " (" << stats.step.bytes + publishAllocations.bytes << " B)"
+                << " | neighbors: " << stats.neighbors.count << " (" << stats.neighbors.bytes << " B)"
+                << " | movement: " << stats.movement.count << " (" << stats.movement.bytes << " B)"
+                << " | publish: " << publishAllocations.count << " (" << publishAllocations.bytes << " B)"
+                << " | arena: " << stats.arenaBytes << " B" << std::endl;
+        }
+
+        publisher.Close();
+        return 0;
+    }
+
     // Initialization
     const int screenWidth = 1600;
     const int screenHeight = 900;
 
     InitWindow(screenWidth, screenHeight, "raylib boids - Keith Lerner");
 
-    Bounds bounds = { Vector3{ 0.0f, 0.0f, 0.0f }, Vector3One() * 200 };
-    const int spawnCount = 1000;
-
     // Define the camera to look into our 3d world
     Camera3D camera = { 0 };
     camera.position = bounds.Max() + bounds.Extents();  // Camera position
@@ -28,42 +160,37 @@ int main(int argc, char* argv[])
 
     // Spawn boids for management
     GridBins<Boid *> gridBins = GridBins<Boid *>(bounds, 16);
-	std::array<Boid, spawnCount> boids;
-    for (int i = 0; i < spawnCount; i++)
-	{
-		// Generate a random position and velocity for each boid.
-		// Position is within the bounds, velocity is normalized and scaled to 
-        // max speed.
-		Vector3 pos = 
-        { 
-            GetRandomValue(bounds.Min().x, bounds.Max().x), 
-            GetRandomValue(bounds.Min().y, bounds.Max().y),
-            GetRandomValue(bounds.Min().z, bounds.Max().z)
-        };
-
-        Vector3 vel = 
-        {
-            GetRandomValue(-1, 1),
-            GetRandomValue(-1, 1),
-            GetRandomValue(-1, 1)
-        };
-
-        vel = Vector3Normalize(vel);
-		vel = Vector3Scale(vel, Boid::maxSpeed);
-
-        
-        // Create a boid with the generated position and velocity and add it 
-        // to the grid bins for management.
-        boids[i] = Boid{ i, pos, vel};
-
-        // Note: The grid bins are not used in this example, at the moment 
-        // they decrease performance rather than increase it. Grid bins were 
-        // an idea caried over from the C# for Unity version of this project.
-        //int binIndex = gridBins.WorldPosToVectorIndex(pos);
-        //if (binIndex >= 0 && binIndex < gridBins.Bins().size())
-        //    gridBins.Bins()[binIndex].push_back(boid);
-    }
-
+    flock.Spawn(spawnCount);
+    std::vector<Boid>& boids = flock.Boids();
+
+    // Note: The grid bins are not used in this example, at the moment 
+    // they decrease performance rather than increase it. Grid bins were 
+    // an idea caried over from the C# for Unity version of this project.
+    //for (int i = 0; i < spawnCount; i++)
+    //{
+    //    int binIndex = gridBins.WorldPosToVectorIndex(boids[i].position);
+    //    if (binIndex >= 0 && binIndex < gridBins.Bins().size())
+    //        gridBins.Bins()[binIndex].push_back(&boids[i]);
+    //}
+
+    // Bake wind, an attractor and a circling predator into the force field,
+    // on top of any loaded grid. Only the region around the predator is 
+    // rebaked as it moves.
+    forceField.AddSource(ForceSource{ FORCE_WIND, bounds.Center(),
+        Vector3{ 1.0f, 0.0f, 0.25f }, 0.0f, 0.5f });
+    forceField.AddSource(ForceSource{ FORCE_ATTRACTOR, 
+        bounds.Center() + Vector3{ -50.0f, 20.0f, 0.0f }, Vector3Zero(), 60.0f, 3.0f });
+    int predator = forceField.AddSource(ForceSource{ FORCE_REPULSOR,
+        bounds.Center(), Vector3Zero(), 40.0f, 12.0f });
+    flock.SetForceField(&forceField);
+
+    // Debug view of one horizontal slice of the force field
+    bool showFieldSlice = false;
+    int fieldSlice = forceField.Resolution() / 2;
+
+    // Allocations made while drawing, shown on the next frame
+    AllocationCounters drawAllocations;
+    AllocationCounters lastDrawAllocations;
 
     DisableCursor(); // Limit cursor to relative movement inside the window
 
@@ -71,8 +198,11 @@ int main(int argc, char* argv[])
     //--------------------------------------------------------------------------------------
 
     // Main game loop
-    while (!WindowShouldClose()) // Detect window close button or ESC key
+    while (!WindowShouldClose() && !stopRequested) // Detect window close button, ESC key or Ctrl+C
     {
+        lastDrawAllocations = drawAllocations;
+        drawAllocations = AllocationCounters();
+
         // Update the camera and reset camera if requested
         UpdateCamera(&camera, CAMERA_FREE);
         if (IsKeyPressed('Z')) 
@@ -81,56 +211,32 @@ int main(int argc, char* argv[])
             camera.target = bounds.Center();
         }
 
-        // Update all Boids
-        for (int i = 0; i < spawnCount; i++)
-		{
-			Boid boid = boids[i];
-            Vector3 pos = boid.position;
-
-            /*int binArrayIndex = gridBins.WorldPosToVectorIndex(pos);
-			if (binArrayIndex < 0) continue;*/
-
-            std::vector<Boid> neighbors = std::vector<Boid>{};
-
-            for (size_t j = 0; j < boids.size(); j++)
-            {
-                if (boids[j].id == boid.id) continue;
-
-                if (Vector3Distance(boids[j].position, boid.position) <=
-                    boid.senseDistance)
-                    neighbors.push_back(boids[j]);
-            }
+        // Toggle and move the force field slice
+        if (IsKeyPressed('F')) showFieldSlice = !showFieldSlice;
+        if (IsKeyPressed('[') && fieldSlice > 0) fieldSlice--;
+        if (IsKeyPressed(']') && fieldSlice < forceField.Resolution() - 1) fieldSlice++;
 
-            // NOTE: Grid bins are not being used. See line64 for further information.
-            /*std::vector<int> searchBins = 
-                gridBins.GetNeighborBinIndices(binArrayIndex);
-            for (size_t j = 0; j < searchBins.size(); j++)
+        // Circle the predator around the center of the bounds
+        float time = (float)GetTime() * 0.5f;
+        forceField.MoveSource(predator, bounds.Center() + Vector3
             {
-				int arrayIndex = searchBins[j];
-
-                std::vector<Boid> binBoids = gridBins.Bins()[arrayIndex];
-                for (size_t k = 0; k < binBoids.size(); k++)
-                {
-					if (binBoids[k].id == boid.id) continue;
-
-					if (Vector3Distance(binBoids[k].position, boid.position) <= 
-                        boid.senseDistance)
-						neighbors.push_back(binBoids[k]);
-                }
-            }*/
+                cosf(time) * bounds.Extents().x * 0.6f,
+                sinf(time * 2.0f) * bounds.Extents().y * 0.3f,
+                sinf(time) * bounds.Extents().z * 0.6f
+            });
 
-			// Update the boid's data
-			boids[i].Movement(neighbors, bounds);
-			boids[i].FixToBounds(bounds);
+        // Update all Boids
+        flock.Step(GetFrameTime());
 
-            // NOTE: Grid bins are not being used. See line64 for further information.
-            /*int calculatedBinIndex = gridBins.WorldPosToVectorIndex(boid.position);
-			if (calculatedBinIndex < 0 || calculatedBinIndex >= gridBins.Bins().size())
-				continue;
-			boids[i].UpdateBinIndex(calculatedBinIndex);*/
+        // Share the completed frame with any external readers
+        AllocationCounters publishAllocations;
+        {
+            AllocationScope publishScope(publishAllocations);
+            publisher.Publish(++frameNumber, boids.data(), flock.Count());
         }
 
         // Start drawing to the window
+        AllocationScope drawScope(drawAllocations);
         BeginDrawing(); 
 
 		// Clear the window and set the background color
@@ -166,7 +272,7 @@ int main(int argc, char* argv[])
             DrawCapsule(pos, pos - normalizedVel * 2.0f, 1.0f, 2, 4, color);
 
             // NOTE: The following section was used for debugging grid bins 
-            // which are not in use. See line 64 for more information.
+            // which are not in use. See where boids are spawned for more information.
             continue; // COMMENT THIS LINE TO DRAW BIN OF BOID 0
 			if (i != 0) continue;
 			int calculatedBinIndex = gridBins.WorldPosToVectorIndex(pos);
@@ -178,6 +284,28 @@ int main(int argc, char* argv[])
 			DrawCubeWiresV(debugBoxCenter, debugBoxSize, YELLOW);
         }
 
+        // Draw the force field slice as lines along the baked force
+        if (showFieldSlice)
+        {
+            for (int z = 0; z < forceField.Resolution(); z++)
+            {
+                for (int x = 0; x < forceField.Resolution(); x++)
+                {
+                    Vector3 samplePos = forceField.SamplePosition(x, fieldSlice, z);
+                    Vector3 force = forceField.SampleAt(x, fieldSlice, z);
+                    DrawLine3D(samplePos, samplePos + force * 2.0f, SKYBLUE);
+                }
+            }
+
+            const std::vector<ForceSource>& sources = forceField.Sources();
+            for (size_t i = 0; i < sources.size(); i++)
+            {
+                if (sources[i].type == FORCE_WIND) continue;
+                DrawSphere(sources[i].position, 3.0f, 
+                    sources[i].type == FORCE_REPULSOR ? ORANGE : SKYBLUE);
+            }
+        }
+
 		// Draw the bounds of the simulation
         DrawCubeWiresV(bounds.Center(), bounds.Size(), Color{ 128, 128, 128, 128 });
 
@@ -185,13 +313,37 @@ int main(int argc, char* argv[])
         EndMode3D();
 
         // Draw UI elements on top of 3D drawings
-        DrawRectangle(10, 10, 320, 93, Fade(RAYWHITE, 0.75f));
-        DrawRectangleLines(10, 10, 320, 93, BLACK);
+        DrawRectangle(10, 10, 320, 133, Fade(RAYWHITE, 0.75f));
+        DrawRectangleLines(10, 10, 320, 133, BLACK);
 
         DrawText("Free camera default controls:", 20, 20, 10, BLACK);
         DrawText("- Mouse Wheel to Zoom in-out", 40, 40, 10, DARKGRAY);
         DrawText("- Mouse Wheel Pressed to Pan", 40, 60, 10, DARKGRAY);
         DrawText("- Z to reset camera view", 40, 80, 10, DARKGRAY);
+        DrawText("- F to toggle force field slice", 40, 100, 10, DARKGRAY);
+        DrawText(TextFormat("- [ and ] to move slice (%d)", fieldSlice), 40, 120, 10, DARKGRAY);
+
+        // Display allocations made during the last frame, by phase
+        const FlockFrameStats& stats = flock.LastFrameStats();
+        AllocationCounters frameAllocations = stats.step;
+        frameAllocations += publishAllocations;
+        frameAllocations += lastDrawAllocations;
+
+        DrawRectangle(10, 153, 320, 133, Fade(RAYWHITE, 0.75f));
+        DrawRectangleLines(10, 153, 320, 133, BLACK);
+
+        DrawText(TextFormat("Allocations per frame: %llu (%llu bytes)", 
+            frameAllocations.count, frameAllocations.bytes), 20, 163, 10, BLACK);
+        DrawText(TextFormat("- Neighbors: %llu (%llu bytes)", 
+            stats.neighbors.count, stats.neighbors.bytes), 40, 183, 10, DARKGRAY);
+        DrawText(TextFormat("- Movement: %llu (%llu bytes)", 
+            stats.movement.count, stats.movement.bytes), 40, 203, 10, DARKGRAY);
+        DrawText(TextFormat("- Publish: %llu (%llu bytes)", 
+            publishAllocations.count, publishAllocations.bytes), 40, 223, 10, DARKGRAY);
+        DrawText(TextFormat("- Draw: %llu (%llu bytes)", 
+            lastDrawAllocations.count, lastDrawAllocations.bytes), 40, 243, 10, DARKGRAY);
+        DrawText(TextFormat("Frame arena: %llu bytes", 
+            (unsigned long long)stats.arenaBytes), 20, 263, 10, BLACK);
 
         // Display the current FPS in the top right corner
 		DrawFPS(1500, 20); 
@@ -201,6 +353,7 @@ int main(int argc, char* argv[])
     }
 
     // De-Initialization
+    publisher.Close();
     CloseWindow(); // Close window and OpenGL context
 
     return 0;
@@ -0,0 +1,252 @@
+#include "ParameterSweep.h"
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+#include "Bounds.h"
+#include "Flock.h"
+
+bool SweepSpec::Load(const std::string& path)
+{
+	std::ifstream file(path);
+	if (!file)
+	{
+		std::cout << "Could not open sweep spec " << path << std::endl;
+		return false;
+	}
+
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(file, line))
+	{
+		lineNumber++;
+
+		// Strip comments and skip blank lines
+		size_t comment = line.find('#');
+		if (comment != std::string::npos) line.erase(comment);
+
+		std::istringstream stream(line);
+		std::string key;
+		if (!(stream >> key)) continue;
+
+		bool valid = true;
+		if (key == "mode")
+		{
+			std::string mode;
+			valid = (bool)(stream >> mode) && (mode == "grid" || mode == "random");
+			randomSamples = mode == "random";
+		}
+		else if (key == "samples") valid = (bool)(stream >> samples) && samples > 0;
+		else if (key == "seeds") valid = (bool)(stream >> seeds) && seeds > 0;
+		else if (key == "steps") valid = (bool)(stream >> steps) && steps > 0;
+		else if (key == "boids") valid = (bool)(stream >> boids) && boids > 0;
+		else if (key == "size") valid = (bool)(stream >> size) && size > 0.0f;
+		else if (key == "threads") valid = (bool)(stream >> threads) && threads >= 0;
+		else if (key == "seed") valid = (bool)(stream >> seed);
+		else if (key == "param")
+		{
+			SweepParameter parameter;
+			BoidSettings probe;
+			valid = (bool)(stream >> parameter.name >> parameter.min) &&
+				ParameterSweep::SetParameter(probe, parameter.name, parameter.min);
+
+			// A lone value holds the parameter fixed, a range defaults to
+			// sweeping just its two ends. Whatever follows min must parse,
+			// so a typo cannot quietly hold the parameter fixed.
+			parameter.max = parameter.min;
+			if (valid && !(stream >> std::ws).eof())
+			{
+				valid = (bool)(stream >> parameter.max);
+				parameter.steps = 2;
+				if (valid && !(stream >> std::ws).eof())
+					valid = (bool)(stream >> parameter.steps);
+				valid = valid && parameter.steps > 0 && parameter.min <= parameter.max;
+			}
+
+			if (valid) parameters.push_back(parameter);
+		}
+		else valid = false;
+
+		// Reject anything left over, such as the "x" of "2x" or an extra value
+		if (valid && !(stream >> std::ws).eof()) valid = false;
+
+		if (!valid)
+		{
+			std::cout << path << ":" << lineNumber << ": invalid line: " << line << std::endl;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool ParameterSweep::SetParameter(BoidSettings& settings, const std::string& name, float value)
+{
+	if (name == "maxSpeed") settings.maxSpeed = value;
+	else if (name == "alignmentWeight") settings.alignmentWeight = value;
+	else if (name == "cohesionWeight") settings.cohesionWeight = value;
+	else if (name == "separationWeight") settings.separationWeight = value;
+	else if (name == "avoidEdgesWeight") settings.avoidEdgesWeight = value;
+	else if (name == "separationDistance") settings.separationDistance = value;
+	else if (name == "senseDistance") settings.senseDistance = value;
+	else return false;
+
+	return true;
+}
+
+std::vector<SweepRun> ParameterSweep::ExpandRuns(const SweepSpec& spec)
+{
+	std::vector<BoidSettings> samples;
+
+	if (spec.randomSamples)
+	{
+		std::mt19937 random(spec.seed);
+		for (int i = 0; i < spec.samples; i++)
+		{
+			BoidSettings settings;
+			for (size_t p = 0; p < spec.parameters.size(); p++)
+			{
+				const SweepParameter& parameter = spec.parameters[p];
+				std::uniform_real_distribution<float> value(parameter.min, parameter.max);
+				SetParameter(settings, parameter.name, value(random));
+			}
+			samples.push_back(settings);
+		}
+	}
+	else
+	{
+		// Walk every combination of parameter steps like an odometer
+		std::vector<int> step(spec.parameters.size(), 0);
+		while (true)
+		{
+			BoidSettings settings;
+			for (size_t p = 0; p < spec.parameters.size(); p++)
+			{
+				const SweepParameter& parameter = spec.parameters[p];
+				float t = parameter.steps > 1 ? (float)step[p] / (parameter.steps - 1) : 0.0f;
+				SetParameter(settings, parameter.name,
+					parameter.min + (parameter.max - parameter.min) * t);
+			}
+			samples.push_back(settings);
+
+			size_t p = 0;
+			while (p < step.size() && ++step[p] >= spec.parameters[p].steps)
+				step[p++] = 0;
+			if (p == step.size()) break;
+		}
+	}
+
+	// Every sample uses the same seeds so results can be compared pairwise
+	std::vector<SweepRun> runs;
+	runs.reserve(samples.size() * spec.seeds);
+	for (size_t i = 0; i < samples.size(); i++)
+	{
+		for (int s = 0; s < spec.seeds; s++)
+		{
+			SweepRun run;
+			run.index = (int)runs.size();
+			run.sample = (int)i;
+			run.seed = spec.seed + s;
+			run.settings = samples[i];
+			runs.push_back(run);
+		}
+	}
+
+	return runs;
+}
+
+SweepResult ParameterSweep::Execute(const SweepSpec& spec, const SweepRun& run)
+{
+	const float deltaTime = 1.0f / 60.0f;
+
+	Bounds bounds = Bounds(Vector3{ 0.0f, 0.0f, 0.0f }, Vector3One() * spec.size);
+	Flock flock = Flock(bounds, run.settings, run.seed);
+	flock.Spawn(spec.boids);
+
+	SweepResult result;
+	double neighborTotal = 0.0;
+	double stepMsTotal = 0.0;
+	for (int i = 0; i < spec.steps; i++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		flock.Step(deltaTime);
+		auto end = std::chrono::steady_clock::now();
+
+		stepMsTotal += std::chrono::duration<double, std::milli>(end - start).count();
+		neighborTotal += flock.LastFrameStats().meanNeighborCount;
+	}
+
+	result.polarization = flock.Polarization();
+	result.clusterCount = flock.ClusterCount();
+	result.meanNeighborCount = (float)(neighborTotal / spec.steps);
+	result.meanStepMs = stepMsTotal / spec.steps;
+	return result;
+}
+
+bool ParameterSweep::Run(const std::string& specPath, const std::string& csvPath)
+{
+	SweepSpec spec;
+	if (!spec.Load(specPath)) return false;
+
+	std::ofstream csv(csvPath);
+	if (!csv)
+	{
+		std::cout << "Could not open " << csvPath << " for writing" << std::endl;
+		return false;
+	}
+
+	std::vector<SweepRun> runs = ExpandRuns(spec);
+	std::vector<SweepResult> results(runs.size());
+
+	int threadCount = spec.threads > 0 ? spec.threads : (int)std::thread::hardware_concurrency();
+	if (threadCount < 1) threadCount = 1;
+	if (threadCount > (int)runs.size()) threadCount = (int)runs.size();
+
+	std::cout << "Sweeping " << runs.size() << " runs on " << threadCount << " threads" << std::endl;
+
+	// Workers pull the next run until none are left
+	std::atomic<int> nextRun(0);
+	std::atomic<int> finishedRuns(0);
+	std::mutex outputMutex;
+	auto worker = [&]()
+	{
+		for (int i = nextRun++; i < (int)runs.size(); i = nextRun++)
+		{
+			results[i] = Execute(spec, runs[i]);
+
+			int finished = ++finishedRuns;
+			std::lock_guard<std::mutex> lock(outputMutex);
+			std::cout << "Run " << finished << "/" << runs.size() << " done" << std::endl;
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (int i = 0; i < threadCount; i++)
+		threads.push_back(std::thread(worker));
+	for (size_t i = 0; i < threads.size(); i++)
+		threads[i].join();
+
+	csv << "run,sample,seed,maxSpeed,alignmentWeight,cohesionWeight,separationWeight,"
+		"avoidEdgesWeight,separationDistance,senseDistance,"
+		"polarization,clusterCount,meanNeighborCount,meanStepMs\n";
+	for (size_t i = 0; i < runs.size(); i++)
+	{
+		const SweepRun& run = runs[i];
+		const BoidSettings& settings = run.settings;
+		const SweepResult& result = results[i];
+		csv << run.index << "," << run.sample << "," << run.seed << ","
+			<< settings.maxSpeed << "," << settings.alignmentWeight << ","
+			<< settings.cohesionWeight << "," << settings.separationWeight << ","
+			<< settings.avoidEdgesWeight << "," << settings.separationDistance << ","
+			<< settings.senseDistance << ","
+			<< result.polarization << "," << result.clusterCount << ","
+			<< result.meanNeighborCount << "," << result.meanStepMs << "\n";
+	}
+
+	std::cout << "Wrote " << csvPath << std::endl;
+	return (bool)csv;
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "Boid.h"
+
+/// <summary>
+/// One boid setting to vary: grid sweeps take steps evenly spaced values from
+/// min to max, random sweeps draw uniformly from [min, max].
+/// </summary>
+struct SweepParameter
+{
+	std::string name;
+	float min = 0.0f;
+	float max = 0.0f;
+	int steps = 1;
+};
+
+/// <summary>
+/// Sweep description, loaded from a text file with one option per line:
+///
+///     mode grid                      # grid or random
+///     samples 64                     # random mode: parameter samples
+///     seeds 4                        # runs per parameter combination
+///     steps 600                      # simulation steps per run
+///     boids 500                      # boids per run
+///     size 200                       # edge length of the cubic bounds
+///     threads 0                      # worker threads, 0 uses every core
+///     seed 1                         # base seed for sampling and runs
+///     param alignmentWeight 1 4 4    # name min [max [steps]], min <= max
+/// </summary>
+struct SweepSpec
+{
+	bool randomSamples = false;
+	int samples = 16;
+	int seeds = 1;
+	int steps = 600;
+	int boids = 500;
+	float size = 200.0f;
+	int threads = 0;
+	unsigned int seed = 1;
+	std::vector<SweepParameter> parameters;
+
+	/// <summary>
+	/// Read a sweep spec from a file, printing the first problem found.
+	/// </summary>
+	/// <returns> False if the file could not be read or is invalid. </returns>
+	bool Load(const std::string& path);
+};
+
+/// <summary>
+/// Settings and seed of a single simulation in the sweep.
+/// </summary>
+struct SweepRun
+{
+	int index = 0;
+	int sample = 0;
+	unsigned int seed = 0;
+	BoidSettings settings;
+};
+
+/// <summary>
+/// Flock metrics gathered from a single run.
+/// </summary>
+struct SweepResult
+{
+	float polarization = 0.0f;    // Of the final step
+	int clusterCount = 0;         // Of the final step
+	float meanNeighborCount = 0;  // Averaged over every step
+	double meanStepMs = 0.0;      // Averaged over every step
+};
+
+/// <summary>
+/// Runs many headless simulations across every core and collects their
+/// metrics into one CSV file.
+/// </summary>
+class ParameterSweep
+{
+public:
+	/// <summary>
+	/// Set a BoidSettings field by name.
+	/// </summary>
+	/// <returns> False if no setting has that name. </returns>
+	static bool SetParameter(BoidSettings& settings, const std::string& name, float value);
+
+	/// <summary>
+	/// Expand a spec into one run per parameter combination (or sample) and seed.
+	/// </summary>
+	static std::vector<SweepRun> ExpandRuns(const SweepSpec& spec);
+
+	/// <summary>
+	/// Simulate one run to completion on the calling thread.
+	/// </summary>
+	static SweepResult Execute(const SweepSpec& spec, const SweepRun& run);
+
+	/// <summary>
+	/// Execute every run of the spec in parallel and write the results.
+	/// </summary>
+	/// <param name="specPath"> Sweep spec to load. </param>
+	/// <param name="csvPath"> CSV file to write, one row per run. </param>
+	/// <returns> False if the spec was invalid or the CSV could not be written. </returns>
+	static bool Run(const std::string& specPath, const std::string& csvPath);
+};
@@ -0,0 +1 @@
+#include "SwarmPublisher.h"
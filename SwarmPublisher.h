@@ -0,0 +1,132 @@
+#pragma once
+#include <atomic>
+#include <iostream>
+#include <new>
+#include "Boid.h"
+#include "SwarmSharedMemory.h"
+
+/// <summary>
+/// Publishes each completed simulation frame into a named shared memory
+/// region so external processes can map it and read boid state without
+/// sockets or copies on their side. Writes are guarded by a seqlock, so the
+/// simulation never waits on readers.
+/// </summary>
+class SwarmPublisher
+{
+	SharedMemoryRegion region;
+	SwarmFrameHeader* header = nullptr;
+
+public:
+	/// <summary>
+	/// Create the shared region sized for the given number of boids.
+	/// </summary>
+	/// <param name="name"> Shared memory name, e.g. "/raylib_boids". </param>
+	/// <param name="capacity"> Maximum number of boids per frame. </param>
+	/// <returns> False if the region could not be created, or another
+	/// simulation is publishing under the same name. </returns>
+	bool Open(const char* name, int capacity)
+	{
+		if (capacity <= 0) return false;
+
+		size_t size = SwarmSharedMemorySize((uint32_t)capacity);
+		if (!region.Create(name, size))
+		{
+			// Only replace a leftover region that is not a swarm region of
+			// this version, or whose simulation is no longer running
+			if (!RemoveForeignRegion(name) || !region.Create(name, size))
+				return false;
+		}
+
+		header = new (region.Data()) SwarmFrameHeader();
+		header->magic = SwarmSharedMemoryMagic;
+		header->version = SwarmSharedMemoryVersion;
+		header->capacity = (uint32_t)capacity;
+		header->boidCount = 0;
+		header->frameNumber = 0;
+		header->sequence.store(0, std::memory_order_release);
+		header->writerProcess = CurrentProcessId();
+		header->writerOpen.store(1, std::memory_order_release);
+		return true;
+	}
+
+	void Close()
+	{
+		// Let readers that keep their mapping know no more frames are coming
+		if (header != nullptr)
+			header->writerOpen.store(0, std::memory_order_release);
+
+		header = nullptr;
+		region.Close();
+	}
+
+	bool IsOpen() const
+	{
+		return header != nullptr;
+	}
+
+	/// <summary>
+	/// Write a completed frame. Boids beyond the region capacity are dropped.
+	/// </summary>
+	/// <param name="frameNumber"> Frame the boid state belongs to. </param>
+	/// <param name="boids"> Pointer to the first boid of the frame. </param>
+	/// <param name="count"> Number of boids to publish. </param>
+	void Publish(uint64_t frameNumber, const Boid* boids, int count)
+	{
+		if (header == nullptr) return;
+		if (count < 0) count = 0;
+		if ((uint32_t)count > header->capacity) count = (int)header->capacity;
+
+		// Odd sequence marks the frame as being written
+		uint32_t sequence = header->sequence.load(std::memory_order_relaxed);
+		header->sequence.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		float* positions = SwarmPositions(header);
+		float* velocities = SwarmVelocities(header);
+		for (int i = 0; i < count; i++)
+		{
+			positions[i * 3 + 0] = boids[i].position.x;
+			positions[i * 3 + 1] = boids[i].position.y;
+			positions[i * 3 + 2] = boids[i].position.z;
+
+			velocities[i * 3 + 0] = boids[i].velocity.x;
+			velocities[i * 3 + 1] = boids[i].velocity.y;
+			velocities[i * 3 + 2] = boids[i].velocity.z;
+		}
+		header->boidCount = (uint32_t)count;
+		header->frameNumber = frameNumber;
+
+		// Even sequence marks the frame as complete
+		header->sequence.store(sequence + 2, std::memory_order_release);
+	}
+
+private:
+	/// <returns> True if a region with a different layout, or left behind by
+	/// a simulation that has exited, was removed. </returns>
+	static bool RemoveForeignRegion(const char* name)
+	{
+		SharedMemoryRegion existing;
+		if (!existing.Open(name)) return false;
+
+		const SwarmFrameHeader* existingHeader =
+			static_cast<const SwarmFrameHeader*>(existing.Data());
+		bool foreign = existing.Size() < sizeof(SwarmFrameHeader) ||
+			existingHeader->magic != SwarmSharedMemoryMagic ||
+			existingHeader->version != SwarmSharedMemoryVersion;
+		uint32_t writerProcess = foreign ? 0 : existingHeader->writerProcess;
+		bool stale = !foreign &&
+			(existingHeader->writerOpen.load(std::memory_order_acquire) == 0 ||
+			!IsProcessRunning(writerProcess));
+		existing.Close();
+
+		if (!foreign && !stale)
+		{
+			std::cout << "Shared swarm region " << name << " is already in use "
+				"by process " << writerProcess << ". Publish "
+				"under another name." << std::endl;
+			return false;
+		}
+
+		return SharedMemoryRegion::Remove(name);
+	}
+};
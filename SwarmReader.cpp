@@ -0,0 +1 @@
+#include "SwarmReader.h"
@@ -0,0 +1,174 @@
+#pragma once
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "SwarmSharedMemory.h"
+
+/// <summary>
+/// A copy of one published frame, for readers that want to hold onto state.
+/// </summary>
+struct SwarmFrame
+{
+	uint64_t frameNumber = 0;
+	uint32_t boidCount = 0;
+	std::vector<float> positions;
+	std::vector<float> velocities;
+};
+
+/// <summary>
+/// Read side of the shared swarm region. Link with SwarmSharedMemory.cpp; no
+/// raylib dependency. Reads are lock-free and never block the simulation.
+///
+/// Zero-copy usage:
+///     uint32_t sequence;
+///     if (!reader.TryBeginRead(sequence)) ... writer busy or stuck, retry later ...
+///     ... use reader.Positions() / reader.Velocities() ...
+///     if (!reader.EndRead(sequence)) ... frame changed, discard and retry ...
+///
+/// Check IsWriterOpen() to notice the simulation closing the region.
+/// </summary>
+class SwarmReader
+{
+	SharedMemoryRegion region;
+	const SwarmFrameHeader* header = nullptr;
+
+public:
+	/// <summary>
+	/// Map a region created by the simulation's SwarmPublisher.
+	/// </summary>
+	/// <returns> False if the region is missing or not a swarm region. </returns>
+	bool Open(const char* name = SwarmSharedMemoryDefaultName)
+	{
+		Close();
+		if (!region.Open(name)) return false;
+
+		const SwarmFrameHeader* mapped =
+			static_cast<const SwarmFrameHeader*>(region.Data());
+		if (region.Size() < sizeof(SwarmFrameHeader) ||
+			mapped->magic != SwarmSharedMemoryMagic ||
+			mapped->version != SwarmSharedMemoryVersion ||
+			region.Size() < SwarmSharedMemorySize(mapped->capacity))
+		{
+			region.Close();
+			return false;
+		}
+
+		header = mapped;
+		return true;
+	}
+
+	void Close()
+	{
+		header = nullptr;
+		region.Close();
+	}
+
+	bool IsOpen() const
+	{
+		return header != nullptr;
+	}
+
+	uint32_t Capacity() const
+	{
+		return header->capacity;
+	}
+
+	/// <summary>
+	/// False once the simulation has closed the region. A simulation that
+	/// crashed cannot clear this, so readers should also treat a frame number
+	/// that stops advancing, or TryBeginRead failing, as a lost writer.
+	/// </summary>
+	bool IsWriterOpen() const
+	{
+		return header->writerOpen.load(std::memory_order_acquire) != 0;
+	}
+
+	/// <summary>
+	/// Wait for the writer to leave the frame, spinning briefly and then
+	/// yielding, for at most maxSpins checks.
+	/// </summary>
+	/// <param name="sequence"> Sequence to pass to EndRead. </param>
+	/// <param name="maxSpins"> Checks before giving up on the writer. </param>
+	/// <returns> False if the writer stayed mid-frame, e.g. because it died
+	/// while publishing. </returns>
+	bool TryBeginRead(uint32_t& sequence, int maxSpins = 4096) const
+	{
+		for (int spin = 0; spin < maxSpins; spin++)
+		{
+			sequence = header->sequence.load(std::memory_order_acquire);
+			if ((sequence & 1) == 0) return true;
+			if (spin >= 64) std::this_thread::yield();
+		}
+
+		return false;
+	}
+
+	/// <summary>
+	/// Check that nothing was published since the matching TryBeginRead.
+	/// </summary>
+	/// <returns> True if everything read in between is one consistent frame. </returns>
+	bool EndRead(uint32_t sequence) const
+	{
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return header->sequence.load(std::memory_order_relaxed) == sequence;
+	}
+
+	uint64_t FrameNumber() const
+	{
+		return header->frameNumber;
+	}
+
+	uint32_t BoidCount() const
+	{
+		uint32_t count = header->boidCount;
+		return count < header->capacity ? count : header->capacity;
+	}
+
+	/// <summary> Packed x, y, z positions, BoidCount() entries long. </summary>
+	const float* Positions() const
+	{
+		return SwarmPositions(header);
+	}
+
+	/// <summary> Packed x, y, z velocities, BoidCount() entries long. </summary>
+	const float* Velocities() const
+	{
+		return SwarmVelocities(header);
+	}
+
+	/// <summary>
+	/// Copy the latest complete frame, retrying while the writer is active.
+	/// </summary>
+	/// <param name="frame"> Destination, resized as needed. </param>
+	/// <param name="maxAttempts"> Retries before giving up on a busy or 
+	/// stuck writer. </param>
+	/// <returns> False if no consistent frame could be read. </returns>
+	bool CopyFrame(SwarmFrame& frame, int maxAttempts = 64) const
+	{
+		if (header == nullptr) return false;
+
+		frame.positions.resize(3 * (size_t)header->capacity);
+		frame.velocities.resize(3 * (size_t)header->capacity);
+
+		for (int attempt = 0; attempt < maxAttempts; attempt++)
+		{
+			uint32_t sequence;
+			if (!TryBeginRead(sequence)) return false;
+
+			uint32_t count = BoidCount();
+			uint64_t frameNumber = FrameNumber();
+			memcpy(frame.positions.data(), Positions(), sizeof(float) * 3 * count);
+			memcpy(frame.velocities.data(), Velocities(), sizeof(float) * 3 * count);
+
+			if (EndRead(sequence))
+			{
+				frame.frameNumber = frameNumber;
+				frame.boidCount = count;
+				return true;
+			}
+		}
+
+		return false;
+	}
+};
@@ -0,0 +1,209 @@
+#include "SwarmSharedMemory.h"
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+// Windows mapping names may not start with a slash, POSIX names must.
+static const char* PlatformName(const char* regionName)
+{
+	return regionName[0] == '/' ? regionName + 1 : regionName;
+}
+
+bool SharedMemoryRegion::Create(const char* regionName, size_t regionSize)
+{
+	Close();
+
+	ULARGE_INTEGER mappingSize;
+	mappingSize.QuadPart = regionSize;
+
+	mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+		mappingSize.HighPart, mappingSize.LowPart, PlatformName(regionName));
+	if (mapping == nullptr) return false;
+
+	// Never share another live process's mapping
+	if (GetLastError() == ERROR_ALREADY_EXISTS)
+	{
+		CloseHandle(mapping);
+		mapping = nullptr;
+		return false;
+	}
+
+	data = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, regionSize);
+	if (data == nullptr)
+	{
+		CloseHandle(mapping);
+		mapping = nullptr;
+		return false;
+	}
+
+	size = regionSize;
+	owner = true;
+	strncpy_s(name, sizeof(name), regionName, _TRUNCATE);
+	return true;
+}
+
+bool SharedMemoryRegion::Open(const char* regionName)
+{
+	Close();
+
+	mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, PlatformName(regionName));
+	if (mapping == nullptr) return false;
+
+	data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (data == nullptr)
+	{
+		CloseHandle(mapping);
+		mapping = nullptr;
+		return false;
+	}
+
+	MEMORY_BASIC_INFORMATION info;
+	VirtualQuery(data, &info, sizeof(info));
+	size = info.RegionSize;
+	owner = false;
+	strncpy_s(name, sizeof(name), regionName, _TRUNCATE);
+	return true;
+}
+
+void SharedMemoryRegion::Close()
+{
+	if (data != nullptr) UnmapViewOfFile(data);
+	if (mapping != nullptr) CloseHandle(mapping);
+
+	// The mapping is released by the system once the last handle closes.
+	data = nullptr;
+	mapping = nullptr;
+	size = 0;
+	owner = false;
+}
+
+bool SharedMemoryRegion::Remove(const char*)
+{
+	return false;
+}
+
+uint32_t CurrentProcessId()
+{
+	return (uint32_t)GetCurrentProcessId();
+}
+
+bool IsProcessRunning(uint32_t processId)
+{
+	HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, processId);
+	if (process == nullptr) return GetLastError() != ERROR_INVALID_PARAMETER;
+
+	bool running = WaitForSingleObject(process, 0) == WAIT_TIMEOUT;
+	CloseHandle(process);
+	return running;
+}
+
+#else
+
+bool SharedMemoryRegion::Create(const char* regionName, size_t regionSize)
+{
+	Close();
+
+	// Exclusive so a second writer cannot take over (and later unlink) a
+	// region that is still in use
+	descriptor = shm_open(regionName, O_CREAT | O_EXCL | O_RDWR, 0644);
+	if (descriptor < 0) return false;
+
+	if (ftruncate(descriptor, (off_t)regionSize) != 0)
+	{
+		close(descriptor);
+		shm_unlink(regionName);
+		descriptor = -1;
+		return false;
+	}
+
+	void* mapped = mmap(nullptr, regionSize, PROT_READ | PROT_WRITE,
+		MAP_SHARED, descriptor, 0);
+	if (mapped == MAP_FAILED)
+	{
+		close(descriptor);
+		shm_unlink(regionName);
+		descriptor = -1;
+		return false;
+	}
+
+	data = mapped;
+	size = regionSize;
+	owner = true;
+	strncpy(name, regionName, sizeof(name) - 1);
+	return true;
+}
+
+bool SharedMemoryRegion::Open(const char* regionName)
+{
+	Close();
+
+	descriptor = shm_open(regionName, O_RDONLY, 0);
+	if (descriptor < 0) return false;
+
+	struct stat info;
+	if (fstat(descriptor, &info) != 0 || info.st_size <= 0)
+	{
+		close(descriptor);
+		descriptor = -1;
+		return false;
+	}
+
+	void* mapped = mmap(nullptr, (size_t)info.st_size, PROT_READ,
+		MAP_SHARED, descriptor, 0);
+	if (mapped == MAP_FAILED)
+	{
+		close(descriptor);
+		descriptor = -1;
+		return false;
+	}
+
+	data = mapped;
+	size = (size_t)info.st_size;
+	owner = false;
+	strncpy(name, regionName, sizeof(name) - 1);
+	return true;
+}
+
+void SharedMemoryRegion::Close()
+{
+	if (data != nullptr) munmap(data, size);
+	if (descriptor >= 0) close(descriptor);
+	if (owner) shm_unlink(name);
+
+	data = nullptr;
+	descriptor = -1;
+	size = 0;
+	owner = false;
+}
+
+bool SharedMemoryRegion::Remove(const char* regionName)
+{
+	return shm_unlink(regionName) == 0;
+}
+
+uint32_t CurrentProcessId()
+{
+	return (uint32_t)getpid();
+}
+
+bool IsProcessRunning(uint32_t processId)
+{
+	// Signal 0 only checks the process exists; EPERM means it does but
+	// belongs to another user
+	return kill((pid_t)processId, 0) == 0 || errno != ESRCH;
+}
+
+#endif
@@ -0,0 +1,143 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// NOTE: This header is shared between the simulation and external readers, so
+// it must not include raylib (raylib and windows.h declare clashing symbols).
+
+const uint32_t SwarmSharedMemoryMagic = 0x44494F42; // "BOID"
+const uint32_t SwarmSharedMemoryVersion = 3;
+const char* const SwarmSharedMemoryDefaultName = "/raylib_boids";
+
+/// <summary>
+/// Fixed header at the start of the shared swarm region. The header is
+/// followed by two packed arrays of capacity * 3 floats: positions (x, y, z)
+/// then velocities (x, y, z).
+/// </summary>
+struct SwarmFrameHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t capacity;
+	uint32_t boidCount;
+
+	// Seqlock guarding frameNumber, boidCount and the packed arrays. Odd while
+	// the writer is publishing, even once the frame is complete.
+	std::atomic<uint32_t> sequence;
+
+	// Non-zero while the simulation is attached. Cleared when the publisher
+	// closes, so readers holding a mapping can tell the writer has gone.
+	std::atomic<uint32_t> writerOpen;
+
+	// Process ID of the simulation that created the region, so a region left
+	// behind by one that was killed can be told apart from one in use.
+	uint32_t writerProcess;
+	uint32_t reserved;   // Keeps frameNumber 8 byte aligned on every target
+
+	uint64_t frameNumber;
+};
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+	"Seqlock counter must be a plain lock-free word to live in shared memory");
+
+inline size_t SwarmSharedMemorySize(uint32_t capacity)
+{
+	return sizeof(SwarmFrameHeader) + sizeof(float) * 3 * 2 * (size_t)capacity;
+}
+
+inline float* SwarmPositions(SwarmFrameHeader* header)
+{
+	return reinterpret_cast<float*>(header + 1);
+}
+
+inline float* SwarmVelocities(SwarmFrameHeader* header)
+{
+	return SwarmPositions(header) + 3 * (size_t)header->capacity;
+}
+
+inline const float* SwarmPositions(const SwarmFrameHeader* header)
+{
+	return reinterpret_cast<const float*>(header + 1);
+}
+
+inline const float* SwarmVelocities(const SwarmFrameHeader* header)
+{
+	return SwarmPositions(header) + 3 * (size_t)header->capacity;
+}
+
+/// <summary>
+/// ID of the calling process.
+/// </summary>
+uint32_t CurrentProcessId();
+
+/// <summary>
+/// Whether a process with the given ID is still running. Processes that can
+/// not be checked are assumed to be running.
+/// </summary>
+bool IsProcessRunning(uint32_t processId);
+
+/// <summary>
+/// A named, memory mapped region backed by POSIX shared memory (shm_open) or,
+/// on Windows, a pagefile backed file mapping.
+/// </summary>
+class SharedMemoryRegion
+{
+	void* data = nullptr;
+	size_t size = 0;
+	bool owner = false;
+	char name[128] = { 0 };
+
+#ifdef _WIN32
+	void* mapping = nullptr;
+#else
+	int descriptor = -1;
+#endif
+
+public:
+	SharedMemoryRegion() {}
+	~SharedMemoryRegion() { Close(); }
+
+	SharedMemoryRegion(const SharedMemoryRegion&) = delete;
+	SharedMemoryRegion& operator=(const SharedMemoryRegion&) = delete;
+
+	/// <summary>
+	/// Create a new region of the given size for writing.
+	/// </summary>
+	/// <returns> False if a region with this name already exists or the region
+	/// could not be created or mapped. </returns>
+	bool Create(const char* regionName, size_t regionSize);
+
+	/// <summary>
+	/// Map an existing region read-only, sized to whatever the creator made.
+	/// </summary>
+	/// <returns> False if the region does not exist or could not be mapped. </returns>
+	bool Open(const char* regionName);
+
+	/// <summary>
+	/// Unmap the region. The creator also removes the name from the system.
+	/// </summary>
+	void Close();
+
+	/// <summary>
+	/// Remove a region's name left behind by a process that did not close it.
+	/// Windows releases mappings with their last handle, so there it does nothing.
+	/// </summary>
+	/// <returns> True if a name was removed. </returns>
+	static bool Remove(const char* regionName);
+
+	bool IsOpen() const
+	{
+		return data != nullptr;
+	}
+
+	void* Data() const
+	{
+		return data;
+	}
+
+	size_t Size() const
+	{
+		return size;
+	}
+};
@@ -1,10 +1,17 @@
 #pragma once
 #include <iostream>
 #include <array>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <vector>
 #include "raylib.h"
 #include "raymath.h"
 #include "GridBins.h"
 #include "Bounds.h"
+#include "Flock.h"
+#include "ForceField.h"
+#include "AllocationTracker.h"
 
 class Tests
 {
@@ -134,5 +141,290 @@ public:
 		std::cout << "Passed: " << pass << std::endl;
 		std::cout << "Failed: " << fail << std::endl;
 	}
-};
 
+	/// <summary>
+	/// Fails if stepping the flock allocates once it has warmed up, so heap
+	/// allocations cannot creep back into the frame. The flock samples a force
+	/// field with a source moved every frame, as in the windowed build, so
+	/// rebaking and sampling are covered too.
+	/// </summary>
+	/// <returns> True if every steady-state frame was allocation free. </returns>
+	static bool TestSteadyStateAllocations(int boidCount, int warmupFrames, int frames)
+	{
+		Bounds bounds = Bounds(Vector3{ 0, 0, 0 }, Vector3One() * 200);
+		Flock flock = Flock(bounds);
+		flock.Spawn(boidCount);
+
+		ForceField forceField = ForceField(bounds, 16);
+		forceField.AddSource(ForceSource{ FORCE_WIND, Vector3Zero(),
+			Vector3{ 1, 0, 0 }, 0.0f, 0.5f });
+		int predator = forceField.AddSource(ForceSource{ FORCE_REPULSOR,
+			Vector3Zero(), Vector3Zero(), 40.0f, 12.0f });
+		flock.SetForceField(&forceField);
+
+		for (int i = 0; i < warmupFrames; i++)
+		{
+			forceField.MoveSource(predator, Vector3{ cosf(i * 0.1f) * 60, 0, sinf(i * 0.1f) * 60 });
+			flock.Step(1.0f / 60.0f);
+		}
+
+		std::cout << "Boids: " << boidCount << std::endl;
+		std::cout << "Warmup frames: " << warmupFrames << std::endl;
+		std::cout << "----------------------------------------" << std::endl;
+
+		int pass = 0, fail = 0;
+
+		for (int i = 0; i < frames; i++)
+		{
+			float angle = (warmupFrames + i) * 0.1f;
+			AllocationCounters before = AllocationTracker::Current();
+			forceField.MoveSource(predator, Vector3{ cosf(angle) * 60, 0, sinf(angle) * 60 });
+			flock.Step(1.0f / 60.0f);
+			AllocationCounters allocated = AllocationTracker::Current() - before;
+
+			if (allocated.count == 0)
+			{
+				pass++;
+			}
+			else
+			{
+				fail++;
+				std::cout << "Frame: " << warmupFrames + i << std::endl;
+				std::cout << "Allocations: " << allocated.count << " (" << allocated.bytes << " bytes)" << std::endl;
+				std::cout << "FAIL (" << i << ")" << std::endl;
+				std::cout << "----------------------------------------" << std::endl;
+			}
+		}
+
+		std::cout << "Passed: " << pass << std::endl;
+		std::cout << "Failed: " << fail << std::endl;
+
+		return fail == 0;
+	}
+
+	/// <summary>
+	/// Moves a source around a field one step at a time. Each move must mark
+	/// only samples within the source's old and new reach, and baking must
+	/// leave every other sample unchanged. The result is then checked against
+	/// a field baked from scratch, and sources far apart must not rebake the
+	/// space between them. Also checks that sampling between grid points
+	/// reproduces a field that varies linearly along each axis.
+	/// </summary>
+	/// <returns> True if every sample matched. </returns>
+	static bool TestForceFieldDirtyBake(int moves, int resolution)
+	{
+		Bounds bounds = Bounds(Vector3{ 0, 0, 0 }, Vector3One() * 200);
+		ForceSource wind = { FORCE_WIND, Vector3Zero(), Vector3{ 0, 0, 1 }, 0.0f, 2.0f };
+		ForceSource repulsor = { FORCE_REPULSOR, Vector3Zero(), Vector3Zero(), 30.0f, 5.0f };
+
+		ForceField incremental = ForceField(bounds, resolution);
+		incremental.AddSource(wind);
+		int moving = incremental.AddSource(repulsor);
+		incremental.Bake();
+
+		std::cout << "Field resolution: " << resolution << std::endl;
+		std::cout << "Source moves: " << moves << std::endl;
+		std::cout << "----------------------------------------" << std::endl;
+
+		int pass = 0, fail = 0;
+
+		Vector3 min = bounds.Min();
+		Vector3 max = bounds.Max();
+		Vector3 cell = incremental.CellSize();
+		int sampleCount = resolution * resolution * resolution;
+		std::vector<Vector3> before(sampleCount);
+		std::vector<ForceFieldRegion> dirty;
+		for (int i = 0; i < moves; i++)
+		{
+			Vector3 from = repulsor.position;
+			repulsor.position = Vector3
+			{
+				(float)GetRandomValue((int)min.x, (int)max.x),
+				(float)GetRandomValue((int)min.y, (int)max.y),
+				(float)GetRandomValue((int)min.z, (int)max.z)
+			};
+			Vector3 to = repulsor.position;
+
+			for (int s = 0; s < sampleCount; s++)
+				before[s] = incremental.SampleAt(s % resolution,
+					(s / resolution) % resolution, s / (resolution * resolution));
+
+			incremental.MoveSource(moving, repulsor.position);
+
+			// Samples the source reached before or after the move
+			Vector3 reachMin = Vector3Min(from, to) - Vector3One() * repulsor.radius - min;
+			Vector3 reachMax = Vector3Max(from, to) + Vector3One() * repulsor.radius - min;
+			int lower[3] =
+			{
+				(int)floorf(reachMin.x / cell.x),
+				(int)floorf(reachMin.y / cell.y),
+				(int)floorf(reachMin.z / cell.z)
+			};
+			int upper[3] =
+			{
+				(int)ceilf(reachMax.x / cell.x),
+				(int)ceilf(reachMax.y / cell.y),
+				(int)ceilf(reachMax.z / cell.z)
+			};
+
+			bool contained = incremental.IsDirty();
+			dirty.clear();
+			for (int r = 0; r < incremental.DirtyRegionCount(); r++)
+			{
+				const ForceFieldRegion& region = incremental.DirtyRegion(r);
+				for (int a = 0; a < 3; a++)
+					if (region.min[a] < lower[a] || region.max[a] > upper[a]) contained = false;
+				dirty.push_back(region);
+			}
+
+			incremental.Bake();
+
+			int changedOutside = 0;
+			for (int z = 0; z < resolution; z++)
+			{
+				for (int y = 0; y < resolution; y++)
+				{
+					for (int x = 0; x < resolution; x++)
+					{
+						int coords[3] = { x, y, z };
+						bool inDirty = false;
+						for (size_t r = 0; r < dirty.size() && !inDirty; r++)
+						{
+							inDirty = true;
+							for (int a = 0; a < 3; a++)
+								if (coords[a] < dirty[r].min[a] || coords[a] > dirty[r].max[a]) inDirty = false;
+						}
+
+						if (!inDirty && Vector3Distance(incremental.SampleAt(x, y, z),
+							before[incremental.SampleIndex(x, y, z)]) > 0.0f)
+							changedOutside++;
+					}
+				}
+			}
+
+			if (contained && changedOutside == 0)
+			{
+				pass++;
+				continue;
+			}
+
+			fail++;
+			std::cout << "Move: " << from.x << ", " << from.y << ", " << from.z
+				<< " -> " << to.x << ", " << to.y << ", " << to.z << std::endl;
+			std::cout << "Dirty regions: " << dirty.size()
+				<< (contained ? "" : " (outside the source's reach)") << std::endl;
+			std::cout << "Changed outside dirty regions: " << changedOutside << std::endl;
+			std::cout << "FAIL" << std::endl;
+			std::cout << "----------------------------------------" << std::endl;
+		}
+
+		ForceField fresh = ForceField(bounds, resolution);
+		fresh.AddSource(wind);
+		fresh.AddSource(repulsor);
+		fresh.Bake();
+
+		for (int z = 0; z < resolution; z++)
+		{
+			for (int y = 0; y < resolution; y++)
+			{
+				for (int x = 0; x < resolution; x++)
+				{
+					Vector3 a = incremental.SampleAt(x, y, z);
+					Vector3 b = fresh.SampleAt(x, y, z);
+					if (Vector3Distance(a, b) < 0.0001f)
+					{
+						pass++;
+						continue;
+					}
+
+					fail++;
+					std::cout << "Sample: " << x << ", " << y << ", " << z << std::endl;
+					std::cout << "Incremental: " << a.x << ", " << a.y << ", " << a.z << std::endl;
+					std::cout << "Fresh: " << b.x << ", " << b.y << ", " << b.z << std::endl;
+					std::cout << "FAIL" << std::endl;
+					std::cout << "----------------------------------------" << std::endl;
+				}
+			}
+		}
+
+		// Sources changing in opposite corners must not rebake the middle
+		ForceField corners = ForceField(bounds, resolution);
+		corners.Bake();
+		ForceSource lowCorner = { FORCE_ATTRACTOR, min + cell, Vector3Zero(), cell.x * 2, 1.0f };
+		ForceSource highCorner = { FORCE_ATTRACTOR, max - cell, Vector3Zero(), cell.x * 2, 1.0f };
+		corners.AddSource(lowCorner);
+		corners.AddSource(highCorner);
+
+		int cornerSamples = 0;
+		for (int r = 0; r < corners.DirtyRegionCount(); r++)
+			cornerSamples += corners.DirtyRegion(r).SampleCount();
+		if (cornerSamples * 2 < sampleCount)
+		{
+			pass++;
+		}
+		else
+		{
+			fail++;
+			std::cout << "Opposite corner sources marked " << cornerSamples
+				<< " of " << sampleCount << " samples" << std::endl;
+			std::cout << "FAIL" << std::endl;
+			std::cout << "----------------------------------------" << std::endl;
+		}
+
+		// A field that varies linearly along each axis is reproduced exactly
+		// by trilinear interpolation, but not by nearest sampling, swapped
+		// weights or wrong corners. Load it as a base grid of f = (x, 2y, 3z).
+		const char* linearPath = "force_field_test.txt";
+		ForceField linear = ForceField(bounds, resolution);
+		{
+			std::ofstream file(linearPath);
+			file.precision(std::numeric_limits<float>::max_digits10);
+			file << "resolution " << resolution << "\n";
+			for (int z = 0; z < resolution; z++)
+			{
+				for (int y = 0; y < resolution; y++)
+				{
+					for (int x = 0; x < resolution; x++)
+					{
+						Vector3 p = linear.SamplePosition(x, y, z);
+						file << p.x << " " << 2 * p.y << " " << 3 * p.z << "\n";
+					}
+				}
+			}
+		}
+
+		bool loaded = linear.Load(linearPath);
+		std::remove(linearPath);
+		if (!loaded) fail++;
+		linear.Bake();
+
+		for (int i = 0; loaded && i < moves; i++)
+		{
+			Vector3 pos =
+			{
+				GetRandomValue((int)min.x * 10, (int)max.x * 10) * 0.1f,
+				GetRandomValue((int)min.y * 10, (int)max.y * 10) * 0.1f,
+				GetRandomValue((int)min.z * 10, (int)max.z * 10) * 0.1f
+			};
+			Vector3 expected = { pos.x, 2 * pos.y, 3 * pos.z };
+			Vector3 sampled = linear.Sample(pos);
+			if (Vector3Distance(sampled, expected) < 0.01f)
+			{
+				pass++;
+				continue;
+			}
+
+			fail++;
+			std::cout << "World Position: " << pos.x << ", " << pos.y << ", " << pos.z << std::endl;
+			std::cout << "Sampled: " << sampled.x << ", " << sampled.y << ", " << sampled.z << std::endl;
+			std::cout << "Expected: " << expected.x << ", " << expected.y << ", " << expected.z << std::endl;
+			std::cout << "FAIL" << std::endl;
+			std::cout << "----------------------------------------" << std::endl;
+		}
+
+		std::cout << "Passed: " << pass << std::endl;
+		std::cout << "Failed: " << fail << std::endl;
+
+		return fail == 0;
+	}
+};